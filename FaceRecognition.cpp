@@ -9,6 +9,11 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <list>
+#include <cstdint>
+#include <cstdlib>
+#include <bitset>
+#include <algorithm>
 #include <opencv2/core/types_c.h>
 #include <unistd.h> 
 #include <sys/stat.h>
@@ -28,11 +33,44 @@ std::vector<int> labels;        // Labels for training images
 std::vector<std::string> names; // Names corresponding to labels
 int pipe_fd = -1;
 
+// Cache of recent recognition results, keyed by an average hash of the 100x100 face crop.
+// A student standing in front of the kiosk gives nearly identical crops frame after frame,
+// so a crop whose hash is within recognitionCacheTolerance bits of a cached entry, and whose
+// face rectangle overlaps the entry's by at least RECOGNITION_CACHE_MIN_IOU, reuses its result.
+// Entries are re-checked with the model after recognitionCacheMaxHits hits or
+// recognitionCacheMaxAgeMs milliseconds. Unrecognized faces are not cached.
+struct CachedRecognition {
+    uint64_t hash;
+    Rect face;         // Face rectangle where the model produced this result
+    int label;
+    double confidence;
+    int64 createdAt;   // cv::getTickCount() when the model produced this result
+    int hits;
+};
+std::list<CachedRecognition> recognitionCache; // Most recently used entry first
+size_t recognitionCacheCapacity = 8;
+int recognitionCacheTolerance = 0;             // Max differing hash bits (out of 64) for a hit, -1 disables
+bool recognitionCacheToleranceSet = false;     // Set from the command line, skip calibration
+int recognitionCacheMaxHits = 30;
+double recognitionCacheMaxAgeMs = 1000.0;
+size_t recognitionCacheHits = 0;
+size_t recognitionCacheMisses = 0;
+const int RECOGNITION_STATS_INTERVAL = 300;   // Frames between cache statistics logs
+const double RECOGNITION_CACHE_MIN_IOU = 0.5;
+
 bool loadFaceRecognizer();
 bool trainFaceRecognizer();
 bool loadTrainingData();
 void detectAndDraw(Mat& img, CascadeClassifier& cascade, CascadeClassifier& nestedCascade, double scale, bool doRecognize = true);
 VideoCapture initializeCapture();
+uint64_t faceHash(const Mat& face);
+bool isRecognized(int label, double confidence);
+double rectIoU(const Rect& a, const Rect& b);
+void calibrateRecognitionCacheTolerance();
+void predictCached(const Mat& face, const Rect& faceRect, int& label, double& confidence);
+void clearRecognitionCache();
+void resetRecognitionCacheStats();
+void logRecognitionCacheStats();
 
 void initPipe() {
     pipe_fd = open("/tmp/studentName_pipe", O_WRONLY | O_NONBLOCK);
@@ -84,7 +122,10 @@ void startRecognition(CascadeClassifier& cascade, CascadeClassifier& nestedCasca
 
     cout << "Face Recognition Started uuu... Press 'q' to quit\n"<<std::flush;
 
+    resetRecognitionCacheStats();
+
     Mat frame;
+    int frameCount = 0;
     while (true) {
         cout<<"Before capturing frames... "<<std::endl;
         capture >> frame;
@@ -99,6 +140,10 @@ void startRecognition(CascadeClassifier& cascade, CascadeClassifier& nestedCasca
         Mat frameClone = frame.clone();
         detectAndDraw(frameClone, cascade, nestedCascade, scale, true);
 
+        if (++frameCount % RECOGNITION_STATS_INTERVAL == 0) {
+            logRecognitionCacheStats();
+        }
+
         char c = (char)waitKey(10);
         if (c == 'q' || c == 27) {
             break;
@@ -106,9 +151,131 @@ void startRecognition(CascadeClassifier& cascade, CascadeClassifier& nestedCasca
     }
 
     destroyWindow("Face Recognition");
+    logRecognitionCacheStats();
+}
+
+// Average hash: shrink to 8x8, one bit per pixel set when it is brighter than the mean
+uint64_t faceHash(const Mat& face) {
+    Mat tiny;
+    resize(face, tiny, Size(8, 8), 0, 0, INTER_AREA);
+    double mean = cv::mean(tiny)[0];
+    uint64_t hash = 0;
+    for (int i = 0; i < 64; i++) {
+        if (tiny.at<uchar>(i / 8, i % 8) > mean) {
+            hash |= (uint64_t)1 << i;
+        }
+    }
+    return hash;
+}
+
+// A prediction is accepted as a known student only below this confidence distance
+bool isRecognized(int label, double confidence) {
+    return confidence < 100.0 && label >= 0 && label < (int)names.size();
+}
+
+// Intersection over union of two face rectangles
+double rectIoU(const Rect& a, const Rect& b) {
+    double inter = (a & b).area();
+    double uni = a.area() + b.area() - inter;
+    return uni > 0 ? inter / uni : 0.0;
+}
+
+// Predict the label of a 100x100 face crop, reusing a cached result for a similar crop
+// at the same place in the frame. Only accepted results are cached.
+void predictCached(const Mat& face, const Rect& faceRect, int& label, double& confidence) {
+    uint64_t hash = faceHash(face);
+    int64 now = getTickCount();
+
+    for (auto it = recognitionCache.begin(); it != recognitionCache.end(); ++it) {
+        double ageMs = (now - it->createdAt) * 1000.0 / getTickFrequency();
+        if (it->hits >= recognitionCacheMaxHits || ageMs > recognitionCacheMaxAgeMs) {
+            continue; // Stale, let the model confirm it again
+        }
+        int distance = (int)std::bitset<64>(hash ^ it->hash).count();
+        if (distance <= recognitionCacheTolerance && rectIoU(faceRect, it->face) >= RECOGNITION_CACHE_MIN_IOU) {
+            label = it->label;
+            confidence = it->confidence;
+            it->hits++;
+            recognitionCacheHits++;
+            // Move to the front so it is evicted last
+            recognitionCache.splice(recognitionCache.begin(), recognitionCache, it);
+            return;
+        }
+    }
+
+    recognitionCacheMisses++;
+    model->predict(face, label, confidence);
+
+    // Drop stale entries for this face so the fresh result replaces them
+    recognitionCache.remove_if([&](const CachedRecognition& entry) {
+        return rectIoU(faceRect, entry.face) >= RECOGNITION_CACHE_MIN_IOU &&
+            (int)std::bitset<64>(hash ^ entry.hash).count() <= recognitionCacheTolerance;
+    });
+
+    if (!isRecognized(label, confidence)) {
+        return;
+    }
+
+    recognitionCache.push_front({ hash, faceRect, label, confidence, now, 0 });
+    if (recognitionCache.size() > recognitionCacheCapacity) {
+        recognitionCache.pop_back();
+    }
 }
 
+// Derive the cache tolerance from the training gallery: the median hash distance between
+// samples of the same person, kept below the closest pair of samples from different people.
+// Without at least two people to compare, only exact hash matches are reused.
+void calibrateRecognitionCacheTolerance() {
+    if (recognitionCacheToleranceSet) {
+        return;
+    }
 
+    std::vector<uint64_t> hashes;
+    for (const Mat& img : images) {
+        hashes.push_back(faceHash(img));
+    }
+
+    std::vector<int> sameDistances;
+    int minDifferent = 65;
+    for (size_t i = 0; i < hashes.size(); i++) {
+        for (size_t j = i + 1; j < hashes.size(); j++) {
+            int distance = (int)std::bitset<64>(hashes[i] ^ hashes[j]).count();
+            if (labels[i] == labels[j]) {
+                sameDistances.push_back(distance);
+            }
+            else {
+                minDifferent = std::min(minDifferent, distance);
+            }
+        }
+    }
+
+    if (sameDistances.empty() || minDifferent > 64) {
+        recognitionCacheTolerance = 0;
+        std::cerr << "Recognition cache tolerance: 0 (not enough training data to calibrate)\n" << std::flush;
+        return;
+    }
+
+    std::nth_element(sameDistances.begin(), sameDistances.begin() + sameDistances.size() / 2, sameDistances.end());
+    int medianSame = sameDistances[sameDistances.size() / 2];
+    recognitionCacheTolerance = std::max(0, std::min(medianSame, minDifferent - 1));
+    std::cerr << "Recognition cache tolerance: " << recognitionCacheTolerance << " (same person median "
+        << medianSame << ", closest different people " << minDifferent << ")\n" << std::flush;
+}
+
+// Cached results are only valid for the model that produced them
+void clearRecognitionCache() {
+    recognitionCache.clear();
+}
+
+void resetRecognitionCacheStats() {
+    recognitionCacheHits = 0;
+    recognitionCacheMisses = 0;
+}
+
+void logRecognitionCacheStats() {
+    std::cerr << "Recognition cache: " << recognitionCacheHits << " hits, "
+        << recognitionCacheMisses << " misses\n" << std::flush;
+}
 
 // Function to initialize video capture with fallback options
 VideoCapture initializeCapture() {
@@ -196,10 +363,10 @@ void detectAndDraw(Mat& img, CascadeClassifier& cascade,
             // Predict
             int predictedLabel = -1;
             double confidence = 0.0;
-            model->predict(faceROI, predictedLabel, confidence);
+            predictCached(faceROI, r, predictedLabel, confidence);
 
             // If confidence is low enough, consider it a match
-            if (confidence < 100.0 && predictedLabel >= 0 && predictedLabel < names.size()) {
+            if (isRecognized(predictedLabel, confidence)) {
                 name = names[predictedLabel];
                 // More confident = green, less confident = red
                 color = Scalar(0, 255 - confidence * 2.55, confidence * 2.55);
@@ -394,6 +561,8 @@ bool loadTrainingData() {
 
     std::cerr << "Loaded " << images.size() << " images for " << names.size() << " people\n"<<std::flush;
 
+    calibrateRecognitionCacheTolerance();
+
     return !images.empty();
 }
 
@@ -407,6 +576,7 @@ bool trainFaceRecognizer() {
     // Create and train the LBPH Face Recognizer
     model = LBPHFaceRecognizer::create();
     model->train(images, labels);
+    clearRecognitionCache();
 
     std::cerr << "Face recognizer trained successfully\n"<<std::flush;
 
@@ -420,6 +590,7 @@ bool trainFaceRecognizer() {
 // Function to load a trained model if it exists
 bool loadFaceRecognizer() {
     model = LBPHFaceRecognizer::create();
+    clearRecognitionCache();
     try {
         model->read("faces/face_model.yml");
         std::cerr << "Loaded trained model from faces/face_model.yml\n"<<std::flush;
@@ -485,6 +656,22 @@ initPipe();
         cerr << "WARNING: Could not load eye cascade - eye detection disabled\n";
     }
 
+    // Optional recognition cache tolerance, for both modes: [auto] [tolerance]
+    // (0 = exact hash only, -1 = never reuse). Without it the tolerance is calibrated from the gallery.
+    bool autoMode = argc > 1 && string(argv[1]) == "auto";
+    int toleranceArg = autoMode ? 2 : 1;
+    if (argc > toleranceArg) {
+        char* end = nullptr;
+        long tolerance = strtol(argv[toleranceArg], &end, 10);
+        if (end == argv[toleranceArg] || *end != '\0' || tolerance < -1 || tolerance > 64) {
+            cerr << "WARNING: Invalid cache tolerance '" << argv[toleranceArg] << "', expected -1..64. Calibrating from training data\n";
+        }
+        else {
+            recognitionCacheTolerance = (int)tolerance;
+            recognitionCacheToleranceSet = true;
+        }
+    }
+
     // Create faces directory if it doesn't exist
     fs::create_directories("faces");
 
@@ -493,7 +680,7 @@ initPipe();
     loadFaceRecognizer();
 	
 	   // Non-interactive mode
-    if (argc > 1 && string(argv[1]) == "auto") {
+    if (autoMode) {
         cout << "=== DETECTED AUTO MODE - GOING TO startRecognition() ===" << endl;
         startRecognition(cascade, nestedCascade, scale);
         return 0;